@@ -32,6 +32,7 @@
 #include "core/io/resource_importer.h"
 #include "core/io/resource_saver.h"
 #include "core/os/file_access.h"
+#include "tensorflow_memory.h"
 
 void TensorflowModel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_data", "data"), &TensorflowModel::set_data);
@@ -42,7 +43,28 @@ void TensorflowModel::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "path"), "load_model", "get_model");
 }
 
+void TensorflowModel::_release_owners() {
+	// Owner interpreters point into data, drop them before it changes.
+	// They get rebuilt from the new buffer on their next inference.
+	Set<ObjectID> current = owners;
+	for (Set<ObjectID>::Element *E = current.front(); E; E = E->next()) {
+		Object *owner = ObjectDB::get_instance(E->get());
+		if (owner) {
+			owner->call("release_interpreter");
+		} else {
+			owners.erase(E->get());
+		}
+	}
+}
+
+void TensorflowModel::_update_memory() {
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->set_model_bytes(this, data.size());
+	}
+}
+
 void TensorflowModel::set_data(const PoolVector<uint8_t> &p_data) {
+	_release_owners();
 	if (!data.empty()) {
 		data.clear();
 	}
@@ -55,6 +77,7 @@ void TensorflowModel::set_data(const PoolVector<uint8_t> &p_data) {
 		uint8_t *dataptr = data.ptrw();
 		copymem(dataptr, r.ptr(), p_data.size());
 	}
+	_update_memory();
 }
 
 PoolVector<uint8_t> TensorflowModel::get_data() const {
@@ -72,6 +95,24 @@ PoolVector<uint8_t> TensorflowModel::get_data() const {
 	return pv;
 }
 
+const uint8_t *TensorflowModel::get_data_ptr() const {
+	return data.ptr();
+}
+
+int TensorflowModel::get_data_size() const {
+	return data.size();
+}
+
+void TensorflowModel::register_owner(Object *p_owner) {
+	ERR_FAIL_NULL(p_owner);
+	owners.insert(p_owner->get_instance_id());
+}
+
+void TensorflowModel::unregister_owner(Object *p_owner) {
+	ERR_FAIL_NULL(p_owner);
+	owners.erase(p_owner->get_instance_id());
+}
+
 Error TensorflowModel::load_model(String p_path) {
 	path = p_path;
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
@@ -80,15 +121,20 @@ Error TensorflowModel::load_model(String p_path) {
 	}
 	Vector<uint8_t> raw_data;
 	size_t length = f->get_len();
-	ERR_FAIL_COND_V(length == 0, ERR_FILE_CORRUPT);
-	raw_data.resize(length);
-	f->get_buffer(raw_data.ptrw(), length);
+	if (length > 0) {
+		raw_data.resize(length);
+		f->get_buffer(raw_data.ptrw(), length);
+	}
+	f->close();
+	memdelete(f);
+	// The identifier sits at bytes 4-7, anything shorter can't be a model.
+	ERR_FAIL_COND_V(length < 8, ERR_FILE_CORRUPT);
 	if (raw_data[4] != 'T' || raw_data[5] != 'F' || raw_data[6] != 'L' || raw_data[7] != '3') {
 		ERR_FAIL_V(ERR_FILE_UNRECOGNIZED);
 	}
-	data.clear();
-	data.resize(length);
-	copymem(data.ptrw(), raw_data.ptr(), raw_data.size());
+	_release_owners();
+	data = raw_data;
+	_update_memory();
 	return OK;
 }
 
@@ -98,4 +144,10 @@ String TensorflowModel::get_model() {
 		return "";
 	}
 	return path;
-}
\ No newline at end of file
+}
+
+TensorflowModel::~TensorflowModel() {
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->set_model_bytes(this, 0);
+	}
+}
@@ -35,6 +35,7 @@
 #include "core/io/resource_saver.h"
 #include "core/os/file_access.h"
 #include "core/resource.h"
+#include "core/set.h"
 
 class TensorflowModel : public Resource {
 	GDCLASS(TensorflowModel, Resource);
@@ -42,6 +43,10 @@ class TensorflowModel : public Resource {
 private:
 	Vector<uint8_t> data;
 	String path;
+	Set<ObjectID> owners;
+
+	void _release_owners();
+	void _update_memory();
 
 protected:
 	static void _bind_methods();
@@ -49,8 +54,14 @@ protected:
 public:
 	void set_data(const PoolVector<uint8_t> &p_data);
 	PoolVector<uint8_t> get_data() const;
+	// Interpreters are built straight from this buffer, without copying it.
+	const uint8_t *get_data_ptr() const;
+	int get_data_size() const;
+	void register_owner(Object *p_owner);
+	void unregister_owner(Object *p_owner);
 	Error load_model(String p_path);
 	String get_model();
+	~TensorflowModel();
 };
 
 #endif
@@ -29,16 +29,30 @@
 /*************************************************************************/
 
 #include "register_types.h"
+#include "core/engine.h"
 #include "core/io/resource_loader.h"
 #include "editor/editor_node.h"
 #include "loader_tflite.h"
 #include "tensorflow.h"
+#include "tensorflow_memory.h"
+#include "tensorflow_pipeline.h"
+
+static TensorflowMemory *tensorflow_memory = NULL;
 
 void register_tensorflow_types() {
 	ClassDB::register_virtual_class<AiInstance>();
 	ClassDB::register_class<TensorflowAiInstance>();
 	ClassDB::register_class<TensorflowModel>();
+	ClassDB::register_virtual_class<TensorflowMemory>();
+	ClassDB::register_class<TensorflowPipeline>();
+
+	tensorflow_memory = memnew(TensorflowMemory);
+	Engine::get_singleton()->add_singleton(Engine::Singleton("TensorflowMemory", TensorflowMemory::get_singleton()));
 }
 
 void unregister_tensorflow_types() {
+	if (tensorflow_memory) {
+		memdelete(tensorflow_memory);
+		tensorflow_memory = NULL;
+	}
 }
@@ -43,6 +43,7 @@
 #include <queue>
 
 #include "core/bind/core_bind.h"
+#include "tensorflow_memory.h"
 
 extern bool input_floating;
 template <class T>
@@ -192,6 +193,10 @@ Ref<Texture> TensorflowAiInstance::get_texture() {
 }
 
 void TensorflowAiInstance::set_tensorflow_model(const Ref<TensorflowModel> &p_model) {
+	if (tensorflow_model.is_valid()) {
+		tensorflow_model->unregister_owner(this);
+	}
+	release_interpreter();
 	tensorflow_model = p_model;
 	if (tensorflow_model.is_valid()) {
 		tensorflow_model->register_owner(this);
@@ -203,7 +208,14 @@ Ref<TensorflowModel> TensorflowAiInstance::get_tensorflow_model() const {
 }
 
 void TensorflowAiInstance::inference() {
-	ERR_FAIL_COND(!interpreter);
+	if (!interpreter) {
+		// Never built, or evicted to stay within the memory budget.
+		ERR_FAIL_COND(!_build_interpreter());
+		ERR_FAIL_COND(!_fill_input());
+	}
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->touch(this);
+	}
 
 	// Run inference
 	ERR_FAIL_COND(interpreter->Invoke() != kTfLiteOk);
@@ -213,6 +225,7 @@ void TensorflowAiInstance::inference() {
 void TensorflowAiInstance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("inference"), &TensorflowAiInstance::inference);
 	ClassDB::bind_method(D_METHOD("allocate_tensor_buffers"), &TensorflowAiInstance::allocate_tensor_buffers);
+	ClassDB::bind_method(D_METHOD("release_interpreter"), &TensorflowAiInstance::release_interpreter);
 	ClassDB::bind_method(D_METHOD("set_tensorflow_model", "model"), &TensorflowAiInstance::set_tensorflow_model);
 	ClassDB::bind_method(D_METHOD("get_tensorflow_model"), &TensorflowAiInstance::get_tensorflow_model);
 	ClassDB::bind_method(D_METHOD("set_texture", "texture"), &TensorflowAiInstance::set_texture);
@@ -252,16 +265,39 @@ TensorflowAiInstance::TensorflowAiInstance() {
 	interpreter = NULL;
 }
 
-void TensorflowAiInstance::allocate_tensor_buffers() {
-	ERR_FAIL_COND(texture.is_null());
-	Ref<Image> img = texture->get_data();
-	PoolVector<uint8_t> model_data = tensorflow_model->get_data();
-	PoolVector<uint8_t>::Read r = model_data.read();
-	model = tflite::FlatBufferModel::BuildFromBuffer((const char *)r.ptr(), model_data.size());
+TensorflowAiInstance::~TensorflowAiInstance() {
+	release_interpreter();
+	if (tensorflow_model.is_valid()) {
+		tensorflow_model->unregister_owner(this);
+	}
+}
+
+void TensorflowAiInstance::release_interpreter() {
+	if (!interpreter && !model) {
+		return;
+	}
+	interpreter.reset();
+	model.reset();
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->unregister_interpreter(this);
+	}
+}
+
+bool TensorflowAiInstance::_build_interpreter() {
+	ERR_FAIL_COND_V(tensorflow_model.is_null(), false);
+	ERR_FAIL_COND_V(tensorflow_model->get_data_size() == 0, false);
+	release_interpreter();
+
+	// The model resource outlives the interpreter, so build from its buffer instead of a copy.
+	model = tflite::FlatBufferModel::BuildFromBuffer((const char *)tensorflow_model->get_data_ptr(), tensorflow_model->get_data_size());
+	ERR_FAIL_COND_V(!model, false);
 	tflite::ops::builtin::BuiltinOpResolver resolver;
 	tflite::InterpreterBuilder builder(*model, resolver);
 	builder(&interpreter);
-	ERR_FAIL_COND(interpreter == NULL);
+	if (interpreter == NULL) {
+		model.reset();
+		ERR_FAIL_V(false);
+	}
 
 	interpreter->UseNNAPI(true);
 	interpreter->SetAllowFp16PrecisionForFp32(true);
@@ -269,7 +305,11 @@ void TensorflowAiInstance::allocate_tensor_buffers() {
 	print_verbose("Tensors size: " + itos(interpreter->tensors_size()));
 	print_verbose("Nodes size: " + itos(interpreter->nodes_size()));
 	print_verbose("Inputs: " + itos(interpreter->inputs().size()));
-	ERR_FAIL_COND(interpreter->inputs().size() == 0);
+	if (interpreter->inputs().size() == 0) {
+		interpreter.reset();
+		model.reset();
+		ERR_FAIL_V(false);
+	}
 	print_verbose("Input(0) name: " + String(interpreter->GetInputName(0)));
 
 	int32_t t_size = interpreter->tensors_size();
@@ -284,9 +324,6 @@ void TensorflowAiInstance::allocate_tensor_buffers() {
 	}
 	interpreter->SetNumThreads(_OS::get_singleton()->get_processor_count());
 
-	int32_t input = interpreter->inputs()[0];
-	print_verbose("input:");
-
 	const std::vector<int> inputs = interpreter->inputs();
 	const std::vector<int> outputs = interpreter->outputs();
 
@@ -294,9 +331,24 @@ void TensorflowAiInstance::allocate_tensor_buffers() {
 	print_verbose("number of outputs: " + itos(outputs.size()));
 
 	if (interpreter->AllocateTensors() != kTfLiteOk) {
-		ERR_FAIL_MSG("Tensorflow can't allocate tensors");
+		interpreter.reset();
+		model.reset();
+		ERR_FAIL_V_MSG(false, "Tensorflow can't allocate tensors");
 	}
 
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->register_interpreter(this, TensorflowMemory::get_arena_bytes(interpreter.get()));
+	}
+	return true;
+}
+
+bool TensorflowAiInstance::_fill_input() {
+	ERR_FAIL_COND_V(!interpreter, false);
+	ERR_FAIL_COND_V(texture.is_null(), false);
+	Ref<Image> img = texture->get_data();
+	ERR_FAIL_COND_V(img.is_null(), false);
+
+	int32_t input = interpreter->inputs()[0];
 	TfLiteIntArray *dims = interpreter->tensor(input)->dims;
 	// get input dimension from the input tensor metadata
 	// assuming one input only
@@ -311,7 +363,7 @@ void TensorflowAiInstance::allocate_tensor_buffers() {
 	} else if (wanted_channels == 4) {
 		img->convert(Image::FORMAT_RGBA8);
 	} else {
-		ERR_FAIL_MSG("Tensorflow: invalid image format");
+		ERR_FAIL_V_MSG(false, "Tensorflow: invalid image format");
 	}
 	switch (interpreter->tensor(input)->type) {
 		case kTfLiteFloat32: {
@@ -329,9 +381,17 @@ void TensorflowAiInstance::allocate_tensor_buffers() {
 			break;
 		}
 		default: {
-			ERR_FAIL_MSG("Tensorflow: cannot handle input type " + itos(interpreter->tensor(input)->type) + " yet");
+			ERR_FAIL_V_MSG(false, "Tensorflow: cannot handle input type " + itos(interpreter->tensor(input)->type) + " yet");
 		}
 	}
+	return true;
+}
+
+void TensorflowAiInstance::allocate_tensor_buffers() {
+	ERR_FAIL_COND(texture.is_null());
+	ERR_FAIL_COND(!_build_interpreter());
+	ERR_FAIL_COND(!_fill_input());
+	int32_t input = interpreter->inputs()[0];
 
 	if (interpreter->Invoke() != kTfLiteOk) {
 		ERR_FAIL_MSG("Tensorflow can't invoke");
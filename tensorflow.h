@@ -58,6 +58,8 @@ protected:
 	Ref<Texture> texture;
 	PoolStringArray labels;
 	void _notification(int p_notification);
+	bool _build_interpreter();
+	bool _fill_input();
 
 public:
 	void set_label_path(String p_path);
@@ -70,7 +72,9 @@ public:
 	Ref<TensorflowModel> get_tensorflow_model() const;
 	void inference();
 	TensorflowAiInstance();
+	~TensorflowAiInstance();
 	void allocate_tensor_buffers();
+	void release_interpreter();
 };
 
 #endif
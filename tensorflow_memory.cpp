@@ -0,0 +1,246 @@
+/*************************************************************************/
+/*  tensorflow_memory.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "tensorflow_memory.h"
+
+#include <tensorflow/lite/interpreter.h>
+
+#include "core/os/os.h"
+#include "core/project_settings.h"
+
+TensorflowMemory *TensorflowMemory::singleton = NULL;
+
+TensorflowMemory *TensorflowMemory::get_singleton() {
+	return singleton;
+}
+
+uint64_t TensorflowMemory::get_arena_bytes(const tflite::Interpreter *p_interpreter) {
+	ERR_FAIL_COND_V(!p_interpreter, 0);
+
+	// Weights are kTfLiteMmapRo and point into the model buffer, which is
+	// already accounted for by the model itself.
+	// The planner reuses arena memory between tensors that are not live at the
+	// same time, so measure the extent each arena spans instead of summing
+	// tensor sizes. This misses only the alignment tail of each arena.
+	const char *arena_begin[2] = { NULL, NULL };
+	const char *arena_end[2] = { NULL, NULL };
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < p_interpreter->tensors_size(); i++) {
+		const TfLiteTensor *tensor = p_interpreter->tensor(i);
+		if (!tensor->data.raw_const || tensor->bytes == 0) {
+			continue;
+		}
+		if (tensor->allocation_type == kTfLiteDynamic) {
+			// Dynamic tensors own their own allocation.
+			bytes += tensor->bytes;
+			continue;
+		}
+		int arena;
+		if (tensor->allocation_type == kTfLiteArenaRw) {
+			arena = 0;
+		} else if (tensor->allocation_type == kTfLiteArenaRwPersistent) {
+			arena = 1;
+		} else {
+			continue;
+		}
+		const char *begin = tensor->data.raw_const;
+		const char *end = begin + tensor->bytes;
+		if (!arena_begin[arena] || begin < arena_begin[arena]) {
+			arena_begin[arena] = begin;
+		}
+		if (!arena_end[arena] || end > arena_end[arena]) {
+			arena_end[arena] = end;
+		}
+	}
+	for (int i = 0; i < 2; i++) {
+		if (arena_begin[i]) {
+			bytes += arena_end[i] - arena_begin[i];
+		}
+	}
+	return bytes;
+}
+
+void TensorflowMemory::set_model_bytes(Object *p_model, uint64_t p_bytes) {
+	ERR_FAIL_NULL(p_model);
+	ObjectID id = p_model->get_instance_id();
+
+	Map<ObjectID, uint64_t>::Element *E = models.find(id);
+	if (E) {
+		model_bytes -= E->get();
+		models.erase(E);
+	}
+	if (p_bytes == 0) {
+		return;
+	}
+	models[id] = p_bytes;
+	model_bytes += p_bytes;
+	_enforce_budget(0);
+}
+
+void TensorflowMemory::register_interpreter(Object *p_owner, uint64_t p_arena_bytes) {
+	ERR_FAIL_NULL(p_owner);
+	ObjectID id = p_owner->get_instance_id();
+
+	unregister_interpreter(p_owner);
+	InterpreterEntry entry;
+	entry.arena_bytes = p_arena_bytes;
+	entry.last_used = OS::get_singleton()->get_ticks_usec();
+	interpreters[id] = entry;
+	arena_bytes += p_arena_bytes;
+	_enforce_budget(id);
+}
+
+void TensorflowMemory::unregister_interpreter(Object *p_owner) {
+	ERR_FAIL_NULL(p_owner);
+
+	Map<ObjectID, InterpreterEntry>::Element *E = interpreters.find(p_owner->get_instance_id());
+	if (!E) {
+		return;
+	}
+	arena_bytes -= E->get().arena_bytes;
+	interpreters.erase(E);
+}
+
+void TensorflowMemory::touch(Object *p_owner) {
+	ERR_FAIL_NULL(p_owner);
+
+	Map<ObjectID, InterpreterEntry>::Element *E = interpreters.find(p_owner->get_instance_id());
+	if (E) {
+		E->get().last_used = OS::get_singleton()->get_ticks_usec();
+	}
+}
+
+void TensorflowMemory::_enforce_budget(ObjectID p_keep) {
+	if (budget == 0) {
+		return;
+	}
+
+	while (model_bytes + arena_bytes > budget) {
+		// Evict the interpreter that has been idle the longest.
+		Map<ObjectID, InterpreterEntry>::Element *victim = NULL;
+		for (Map<ObjectID, InterpreterEntry>::Element *E = interpreters.front(); E; E = E->next()) {
+			if (E->key() == p_keep) {
+				continue;
+			}
+			if (!victim || E->get().last_used < victim->get().last_used) {
+				victim = E;
+			}
+		}
+		if (!victim) {
+			WARN_PRINT("Tensorflow: memory budget exceeded and no idle interpreter left to evict.");
+			return;
+		}
+
+		_evict(victim->key());
+	}
+}
+
+void TensorflowMemory::_evict(ObjectID p_id) {
+	Object *owner = ObjectDB::get_instance(p_id);
+	if (owner) {
+		owner->call("release_interpreter");
+	}
+	// The owner is expected to unregister itself, but never keep a stale entry around.
+	Map<ObjectID, InterpreterEntry>::Element *E = interpreters.find(p_id);
+	if (E) {
+		arena_bytes -= E->get().arena_bytes;
+		interpreters.erase(E);
+	}
+	evictions++;
+}
+
+void TensorflowMemory::evict_all() {
+	while (interpreters.size()) {
+		_evict(interpreters.front()->key());
+	}
+}
+
+void TensorflowMemory::set_budget(uint64_t p_budget) {
+	budget = p_budget;
+	_enforce_budget(0);
+}
+
+uint64_t TensorflowMemory::get_budget() const {
+	return budget;
+}
+
+uint64_t TensorflowMemory::get_monitor(Monitor p_monitor) const {
+	switch (p_monitor) {
+		case MONITOR_MODEL_BYTES:
+			return model_bytes;
+		case MONITOR_ARENA_BYTES:
+			return arena_bytes;
+		case MONITOR_TOTAL_BYTES:
+			return model_bytes + arena_bytes;
+		case MONITOR_BUDGET_BYTES:
+			return budget;
+		case MONITOR_RESIDENT_INTERPRETERS:
+			return interpreters.size();
+		case MONITOR_EVICTIONS:
+			return evictions;
+		default:
+			break;
+	}
+	ERR_FAIL_V(0);
+}
+
+void TensorflowMemory::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_budget", "bytes"), &TensorflowMemory::set_budget);
+	ClassDB::bind_method(D_METHOD("get_budget"), &TensorflowMemory::get_budget);
+	ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &TensorflowMemory::get_monitor);
+	ClassDB::bind_method(D_METHOD("evict_all"), &TensorflowMemory::evict_all);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "budget"), "set_budget", "get_budget");
+
+	BIND_ENUM_CONSTANT(MONITOR_MODEL_BYTES);
+	BIND_ENUM_CONSTANT(MONITOR_ARENA_BYTES);
+	BIND_ENUM_CONSTANT(MONITOR_TOTAL_BYTES);
+	BIND_ENUM_CONSTANT(MONITOR_BUDGET_BYTES);
+	BIND_ENUM_CONSTANT(MONITOR_RESIDENT_INTERPRETERS);
+	BIND_ENUM_CONSTANT(MONITOR_EVICTIONS);
+	BIND_ENUM_CONSTANT(MONITOR_MAX);
+}
+
+TensorflowMemory::TensorflowMemory() {
+	model_bytes = 0;
+	arena_bytes = 0;
+	evictions = 0;
+	budget = uint64_t(int(GLOBAL_DEF("tensorflow/memory/budget_mb", 0))) * 1024 * 1024;
+	ProjectSettings::get_singleton()->set_custom_property_info("tensorflow/memory/budget_mb", PropertyInfo(Variant::INT, "tensorflow/memory/budget_mb", PROPERTY_HINT_RANGE, "0,65536,1,or_greater"));
+
+	ERR_FAIL_COND_MSG(singleton != NULL, "Tensorflow: TensorflowMemory is a singleton, use the existing instance");
+	singleton = this;
+}
+
+TensorflowMemory::~TensorflowMemory() {
+	if (singleton == this) {
+		singleton = NULL;
+	}
+}
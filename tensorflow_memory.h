@@ -0,0 +1,99 @@
+/*************************************************************************/
+/*  tensorflow_memory.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TENSORFLOW_MEMORY_H
+#define TENSORFLOW_MEMORY_H
+
+#include "core/map.h"
+#include "core/object.h"
+
+namespace tflite {
+class Interpreter;
+}
+
+// Accounts for the memory held by the module (model weights and interpreter
+// arenas) and keeps it under a budget by evicting the interpreters that have
+// been idle the longest. Evicted owners rebuild their interpreter lazily.
+class TensorflowMemory : public Object {
+	GDCLASS(TensorflowMemory, Object);
+
+public:
+	enum Monitor {
+		MONITOR_MODEL_BYTES,
+		MONITOR_ARENA_BYTES, // Span of each interpreter arena, see get_arena_bytes().
+		MONITOR_TOTAL_BYTES,
+		MONITOR_BUDGET_BYTES,
+		MONITOR_RESIDENT_INTERPRETERS,
+		MONITOR_EVICTIONS,
+		MONITOR_MAX
+	};
+
+private:
+	struct InterpreterEntry {
+		uint64_t arena_bytes;
+		uint64_t last_used;
+	};
+
+	static TensorflowMemory *singleton;
+
+	Map<ObjectID, uint64_t> models;
+	Map<ObjectID, InterpreterEntry> interpreters;
+	uint64_t model_bytes;
+	uint64_t arena_bytes;
+	uint64_t budget;
+	uint64_t evictions;
+
+	void _enforce_budget(ObjectID p_keep);
+	void _evict(ObjectID p_id);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static TensorflowMemory *get_singleton();
+	static uint64_t get_arena_bytes(const tflite::Interpreter *p_interpreter);
+
+	void set_model_bytes(Object *p_model, uint64_t p_bytes);
+	void register_interpreter(Object *p_owner, uint64_t p_arena_bytes);
+	void unregister_interpreter(Object *p_owner);
+	void touch(Object *p_owner);
+	void evict_all();
+
+	void set_budget(uint64_t p_budget);
+	uint64_t get_budget() const;
+	uint64_t get_monitor(Monitor p_monitor) const;
+
+	TensorflowMemory();
+	~TensorflowMemory();
+};
+
+VARIANT_ENUM_CAST(TensorflowMemory::Monitor);
+
+#endif
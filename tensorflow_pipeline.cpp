@@ -0,0 +1,537 @@
+/*************************************************************************/
+/*  tensorflow_pipeline.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "tensorflow_pipeline.h"
+
+#include <tensorflow/lite/kernels/register.h>
+
+#include "core/bind/core_bind.h"
+#include "tensorflow_memory.h"
+
+// Raw bytes can only be handed over when both sides agree on layout and on
+// what each quantized value means.
+static bool tensors_match(const TfLiteTensor *p_a, const TfLiteTensor *p_b) {
+	return p_a->type == p_b->type && p_a->bytes == p_b->bytes &&
+		   TfLiteIntArrayEqual(p_a->dims, p_b->dims) &&
+		   p_a->params.scale == p_b->params.scale &&
+		   p_a->params.zero_point == p_b->params.zero_point;
+}
+
+// Tensors that are not quantized have a scale of 0, keep their raw values.
+static float dequantize(uint8_t p_value, const TfLiteQuantizationParams &p_params) {
+	float scale = p_params.scale != 0 ? p_params.scale : 1.0;
+	return scale * (int32_t(p_value) - p_params.zero_point);
+}
+
+static uint8_t quantize(float p_value, const TfLiteQuantizationParams &p_params) {
+	float scale = p_params.scale != 0 ? p_params.scale : 1.0;
+	return (uint8_t)CLAMP(Math::round(p_value / scale) + p_params.zero_point, 0.0f, 255.0f);
+}
+
+bool TensorflowPipeline::_set(const StringName &p_name, const Variant &p_value) {
+	String name = p_name;
+	if (!name.begins_with("stages/")) {
+		return false;
+	}
+	int stage = name.get_slicec('/', 1).to_int();
+	String what = name.get_slicec('/', 2);
+	ERR_FAIL_INDEX_V(stage, stages.size(), false);
+
+	if (what == "type") {
+		set_stage_type(stage, StageType(int(p_value)));
+	} else if (what == "model") {
+		set_stage_model(stage, p_value);
+	} else if (what == "boxes_output") {
+		set_stage_boxes_output(stage, p_value);
+	} else if (what == "scores_output") {
+		set_stage_scores_output(stage, p_value);
+	} else if (what == "score_threshold") {
+		set_stage_score_threshold(stage, p_value);
+	} else if (what == "max_crops") {
+		set_stage_max_crops(stage, p_value);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool TensorflowPipeline::_get(const StringName &p_name, Variant &r_ret) const {
+	String name = p_name;
+	if (!name.begins_with("stages/")) {
+		return false;
+	}
+	int stage = name.get_slicec('/', 1).to_int();
+	String what = name.get_slicec('/', 2);
+	ERR_FAIL_INDEX_V(stage, stages.size(), false);
+
+	if (what == "type") {
+		r_ret = get_stage_type(stage);
+	} else if (what == "model") {
+		r_ret = get_stage_model(stage);
+	} else if (what == "boxes_output") {
+		r_ret = get_stage_boxes_output(stage);
+	} else if (what == "scores_output") {
+		r_ret = get_stage_scores_output(stage);
+	} else if (what == "score_threshold") {
+		r_ret = get_stage_score_threshold(stage);
+	} else if (what == "max_crops") {
+		r_ret = get_stage_max_crops(stage);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void TensorflowPipeline::_get_property_list(List<PropertyInfo> *p_list) const {
+	for (int i = 0; i < stages.size(); i++) {
+		String prefix = "stages/" + itos(i) + "/";
+		p_list->push_back(PropertyInfo(Variant::INT, prefix + "type", PROPERTY_HINT_ENUM, "Model,Crop Resize"));
+		if (stages[i].type == STAGE_MODEL) {
+			p_list->push_back(PropertyInfo(Variant::OBJECT, prefix + "model", PROPERTY_HINT_RESOURCE_TYPE, "TensorflowModel"));
+		} else {
+			p_list->push_back(PropertyInfo(Variant::INT, prefix + "boxes_output"));
+			p_list->push_back(PropertyInfo(Variant::INT, prefix + "scores_output"));
+			p_list->push_back(PropertyInfo(Variant::REAL, prefix + "score_threshold", PROPERTY_HINT_RANGE, "0,1,0.01"));
+			p_list->push_back(PropertyInfo(Variant::INT, prefix + "max_crops", PROPERTY_HINT_RANGE, "1,256,1,or_greater"));
+		}
+	}
+}
+
+void TensorflowPipeline::set_stage_count(int p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	release_interpreter();
+	stages.resize(p_count);
+	_change_notify();
+	emit_changed();
+}
+
+int TensorflowPipeline::get_stage_count() const {
+	return stages.size();
+}
+
+int TensorflowPipeline::add_model_stage(const Ref<TensorflowModel> &p_model) {
+	int stage = stages.size();
+	set_stage_count(stage + 1);
+	set_stage_model(stage, p_model);
+	return stage;
+}
+
+int TensorflowPipeline::add_crop_resize_stage(int p_boxes_output, int p_scores_output, float p_score_threshold, int p_max_crops) {
+	int stage = stages.size();
+	set_stage_count(stage + 1);
+	set_stage_type(stage, STAGE_CROP_RESIZE);
+	set_stage_boxes_output(stage, p_boxes_output);
+	set_stage_scores_output(stage, p_scores_output);
+	set_stage_score_threshold(stage, p_score_threshold);
+	set_stage_max_crops(stage, p_max_crops);
+	return stage;
+}
+
+void TensorflowPipeline::clear_stages() {
+	set_stage_count(0);
+}
+
+void TensorflowPipeline::set_stage_type(int p_stage, StageType p_type) {
+	ERR_FAIL_INDEX(p_stage, stages.size());
+	release_interpreter();
+	stages.write[p_stage].type = p_type;
+	_change_notify();
+	emit_changed();
+}
+
+TensorflowPipeline::StageType TensorflowPipeline::get_stage_type(int p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, stages.size(), STAGE_MODEL);
+	return stages[p_stage].type;
+}
+
+void TensorflowPipeline::set_stage_model(int p_stage, const Ref<TensorflowModel> &p_model) {
+	ERR_FAIL_INDEX(p_stage, stages.size());
+	release_interpreter();
+	stages.write[p_stage].model = p_model;
+	emit_changed();
+}
+
+Ref<TensorflowModel> TensorflowPipeline::get_stage_model(int p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, stages.size(), Ref<TensorflowModel>());
+	return stages[p_stage].model;
+}
+
+void TensorflowPipeline::set_stage_boxes_output(int p_stage, int p_output) {
+	ERR_FAIL_INDEX(p_stage, stages.size());
+	stages.write[p_stage].boxes_output = p_output;
+	emit_changed();
+}
+
+int TensorflowPipeline::get_stage_boxes_output(int p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, stages.size(), 0);
+	return stages[p_stage].boxes_output;
+}
+
+void TensorflowPipeline::set_stage_scores_output(int p_stage, int p_output) {
+	ERR_FAIL_INDEX(p_stage, stages.size());
+	stages.write[p_stage].scores_output = p_output;
+	emit_changed();
+}
+
+int TensorflowPipeline::get_stage_scores_output(int p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, stages.size(), 0);
+	return stages[p_stage].scores_output;
+}
+
+void TensorflowPipeline::set_stage_score_threshold(int p_stage, float p_threshold) {
+	ERR_FAIL_INDEX(p_stage, stages.size());
+	stages.write[p_stage].score_threshold = p_threshold;
+	emit_changed();
+}
+
+float TensorflowPipeline::get_stage_score_threshold(int p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, stages.size(), 0);
+	return stages[p_stage].score_threshold;
+}
+
+void TensorflowPipeline::set_stage_max_crops(int p_stage, int p_max_crops) {
+	ERR_FAIL_INDEX(p_stage, stages.size());
+	ERR_FAIL_COND(p_max_crops < 1);
+	stages.write[p_stage].max_crops = p_max_crops;
+	emit_changed();
+}
+
+int TensorflowPipeline::get_stage_max_crops(int p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, stages.size(), 0);
+	return stages[p_stage].max_crops;
+}
+
+bool TensorflowPipeline::_build_interpreters() {
+	release_interpreter();
+	ERR_FAIL_COND_V_MSG(stages.size() == 0, false, "Tensorflow: pipeline has no stages");
+	ERR_FAIL_COND_V_MSG(stages[0].type != STAGE_MODEL || stages[stages.size() - 1].type != STAGE_MODEL, false, "Tensorflow: pipeline must start and end with a model stage");
+
+	runtimes.resize(stages.size());
+	for (int i = 0; i < stages.size(); i++) {
+		const Stage &stage = stages[i];
+		StageRuntime &rt = runtimes[i];
+		rt.shared_input = false;
+
+		if (stage.type == STAGE_CROP_RESIZE) {
+			if (stages[i + 1].type != STAGE_MODEL) {
+				release_interpreter();
+				ERR_FAIL_V_MSG(false, "Tensorflow: crop resize stage " + itos(i) + " must be between two model stages");
+			}
+			continue;
+		}
+
+		Ref<TensorflowModel> model = stage.model;
+		if (model.is_null() || model->get_data_size() == 0) {
+			release_interpreter();
+			ERR_FAIL_V_MSG(false, "Tensorflow: pipeline stage " + itos(i) + " has no model");
+		}
+		model->register_owner(this);
+
+		rt.model = tflite::FlatBufferModel::BuildFromBuffer((const char *)model->get_data_ptr(), model->get_data_size());
+		if (rt.model) {
+			tflite::ops::builtin::BuiltinOpResolver resolver;
+			tflite::InterpreterBuilder builder(*rt.model, resolver);
+			builder(&rt.interpreter);
+		}
+		if (!rt.interpreter || rt.interpreter->inputs().size() == 0) {
+			release_interpreter();
+			ERR_FAIL_V_MSG(false, "Tensorflow: can't build interpreter for pipeline stage " + itos(i));
+		}
+		rt.interpreter->SetNumThreads(_OS::get_singleton()->get_processor_count());
+
+		// When the previous model output matches this input exactly, point the input
+		// at the previous arena instead of copying between the two on every run.
+		if (i > 0 && stages[i - 1].type == STAGE_MODEL) {
+			tflite::Interpreter *prev = runtimes[i - 1].interpreter.get();
+			const TfLiteTensor *from = prev->tensor(prev->outputs()[0]);
+			int input = rt.interpreter->inputs()[0];
+			const TfLiteTensor *to = rt.interpreter->tensor(input);
+			if (from->allocation_type == kTfLiteArenaRw && tensors_match(from, to)) {
+				std::vector<int> dims(to->dims->data, to->dims->data + to->dims->size);
+				rt.shared_input = rt.interpreter->SetTensorParametersReadOnly(input, to->type, to->name, dims, to->params, from->data.raw_const, from->bytes) == kTfLiteOk;
+			}
+		}
+
+		if (rt.interpreter->AllocateTensors() != kTfLiteOk) {
+			release_interpreter();
+			ERR_FAIL_V_MSG(false, "Tensorflow: can't allocate tensors for pipeline stage " + itos(i));
+		}
+		print_verbose("Tensorflow: pipeline stage " + itos(i) + (rt.shared_input ? " shares its input with the previous stage" : " copies its input"));
+	}
+
+	uint64_t arena_bytes = 0;
+	for (size_t i = 0; i < runtimes.size(); i++) {
+		if (runtimes[i].interpreter) {
+			arena_bytes += TensorflowMemory::get_arena_bytes(runtimes[i].interpreter.get());
+		}
+	}
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->register_interpreter(this, arena_bytes);
+	}
+	return true;
+}
+
+bool TensorflowPipeline::_fill_from_image(tflite::Interpreter *p_interpreter, const Ref<Image> &p_image, const Rect2 &p_rect) {
+	int input = p_interpreter->inputs()[0];
+	TfLiteTensor *tensor = p_interpreter->tensor(input);
+	ERR_FAIL_COND_V(tensor->dims->size != 4, false);
+	int32_t wanted_height = tensor->dims->data[1];
+	int32_t wanted_width = tensor->dims->data[2];
+	int32_t wanted_channels = tensor->dims->data[3];
+
+	Ref<Image> img = p_image->get_rect(p_rect);
+	ERR_FAIL_COND_V(img.is_null() || img->empty(), false);
+	if (wanted_channels == 3) {
+		img->convert(Image::FORMAT_RGB8);
+	} else if (wanted_channels == 4) {
+		img->convert(Image::FORMAT_RGBA8);
+	} else {
+		ERR_FAIL_V_MSG(false, "Tensorflow: invalid image format");
+	}
+	img->resize(wanted_width, wanted_height, Image::INTERPOLATE_BILINEAR);
+
+	PoolVector<uint8_t> data = img->get_data();
+	PoolVector<uint8_t>::Read r = data.read();
+	int count = wanted_width * wanted_height * wanted_channels;
+	ERR_FAIL_COND_V(data.size() < count, false);
+	switch (tensor->type) {
+		case kTfLiteFloat32: {
+			float *w = p_interpreter->typed_tensor<float>(input);
+			for (int i = 0; i < count; i++) {
+				w[i] = r[i];
+			}
+			break;
+		}
+		case kTfLiteUInt8: {
+			copymem(p_interpreter->typed_tensor<uint8_t>(input), r.ptr(), count);
+			break;
+		}
+		default: {
+			ERR_FAIL_V_MSG(false, "Tensorflow: cannot handle input type " + itos(tensor->type) + " yet");
+		}
+	}
+	return true;
+}
+
+bool TensorflowPipeline::_copy_tensor(const TfLiteTensor *p_from, TfLiteTensor *p_to) {
+	if (tensors_match(p_from, p_to)) {
+		copymem(p_to->data.raw, p_from->data.raw_const, p_from->bytes);
+		return true;
+	}
+
+	if (p_from->type == kTfLiteUInt8 && p_to->type == kTfLiteUInt8) {
+		// Same element count but a different quantization range, requantize.
+		ERR_FAIL_COND_V(p_from->bytes != p_to->bytes, false);
+		const uint8_t *r = p_from->data.uint8;
+		uint8_t *w = p_to->data.uint8;
+		for (size_t i = 0; i < p_to->bytes; i++) {
+			w[i] = quantize(dequantize(r[i], p_from->params), p_to->params);
+		}
+		return true;
+	}
+
+	if (p_from->type == kTfLiteUInt8 && p_to->type == kTfLiteFloat32) {
+		ERR_FAIL_COND_V(p_from->bytes != p_to->bytes / sizeof(float), false);
+		const uint8_t *r = p_from->data.uint8;
+		float *w = p_to->data.f;
+		for (size_t i = 0; i < p_from->bytes; i++) {
+			w[i] = dequantize(r[i], p_from->params);
+		}
+		return true;
+	}
+
+	if (p_from->type == kTfLiteFloat32 && p_to->type == kTfLiteUInt8) {
+		ERR_FAIL_COND_V(p_from->bytes / sizeof(float) != p_to->bytes, false);
+		const float *r = p_from->data.f;
+		uint8_t *w = p_to->data.uint8;
+		for (size_t i = 0; i < p_to->bytes; i++) {
+			w[i] = quantize(r[i], p_to->params);
+		}
+		return true;
+	}
+
+	ERR_FAIL_V_MSG(false, "Tensorflow: can't hand tensor of type " + itos(p_from->type) + " over to type " + itos(p_to->type));
+}
+
+void TensorflowPipeline::_run_stages(int p_from, const Ref<Image> &p_image, const Rect2 &p_rect, float p_score, Array &r_results) {
+	for (int i = p_from; i < stages.size(); i++) {
+		if (stages[i].type == STAGE_CROP_RESIZE) {
+			const Stage &stage = stages[i];
+			tflite::Interpreter *prev = runtimes[i - 1].interpreter.get();
+			ERR_FAIL_INDEX(stage.boxes_output, int(prev->outputs().size()));
+			ERR_FAIL_INDEX(stage.scores_output, int(prev->outputs().size()));
+			const TfLiteTensor *boxes = prev->tensor(prev->outputs()[stage.boxes_output]);
+			const TfLiteTensor *scores = prev->tensor(prev->outputs()[stage.scores_output]);
+			ERR_FAIL_COND_MSG(boxes->type != kTfLiteFloat32 || scores->type != kTfLiteFloat32, "Tensorflow: crop resize stage expects float boxes and scores");
+
+			// Boxes are [ymin, xmin, ymax, xmax], normalized to the rect the detector saw.
+			int count = MIN(scores->bytes / sizeof(float), boxes->bytes / (4 * sizeof(float)));
+			Vector<Rect2> crops;
+			Vector<float> crop_scores;
+			Rect2 bounds(Point2(), p_image->get_size());
+			for (int j = 0; j < count && crops.size() < stage.max_crops; j++) {
+				float score = scores->data.f[j];
+				if (score < stage.score_threshold) {
+					continue;
+				}
+				const float *box = &boxes->data.f[j * 4];
+				Rect2 crop;
+				crop.position = p_rect.position + Point2(box[1], box[0]) * p_rect.size;
+				crop.size = Point2(box[3] - box[1], box[2] - box[0]) * p_rect.size;
+				crop = crop.clip(bounds);
+				crop.position = crop.position.floor();
+				crop.size = crop.size.floor();
+				if (crop.size.x < 1 || crop.size.y < 1) {
+					continue;
+				}
+				crops.push_back(crop);
+				crop_scores.push_back(score);
+			}
+
+			// The detector outputs were copied above, so the rest of the chain can reuse its buffers.
+			for (int j = 0; j < crops.size(); j++) {
+				_run_stages(i + 1, p_image, crops[j], crop_scores[j], r_results);
+			}
+			return;
+		}
+
+		StageRuntime &rt = runtimes[i];
+		if (i == p_from) {
+			ERR_FAIL_COND(!_fill_from_image(rt.interpreter.get(), p_image, p_rect));
+		} else if (!rt.shared_input) {
+			tflite::Interpreter *prev = runtimes[i - 1].interpreter.get();
+			ERR_FAIL_COND(!_copy_tensor(prev->tensor(prev->outputs()[0]), rt.interpreter->tensor(rt.interpreter->inputs()[0])));
+		}
+		ERR_FAIL_COND_MSG(rt.interpreter->Invoke() != kTfLiteOk, "Tensorflow can't invoke pipeline stage " + itos(i));
+	}
+
+	tflite::Interpreter *last = runtimes[stages.size() - 1].interpreter.get();
+	const TfLiteTensor *output = last->tensor(last->outputs()[0]);
+	PoolRealArray values;
+	switch (output->type) {
+		case kTfLiteFloat32: {
+			int count = output->bytes / sizeof(float);
+			values.resize(count);
+			PoolRealArray::Write w = values.write();
+			for (int i = 0; i < count; i++) {
+				w[i] = output->data.f[i];
+			}
+			break;
+		}
+		case kTfLiteUInt8: {
+			int count = output->bytes;
+			values.resize(count);
+			PoolRealArray::Write w = values.write();
+			for (int i = 0; i < count; i++) {
+				w[i] = dequantize(output->data.uint8[i], output->params);
+			}
+			break;
+		}
+		default: {
+			ERR_FAIL_MSG("Tensorflow: cannot handle output type " + itos(output->type) + " yet");
+		}
+	}
+
+	Dictionary result;
+	result["rect"] = p_rect;
+	result["score"] = p_score;
+	result["output"] = values;
+	r_results.push_back(result);
+}
+
+Array TensorflowPipeline::run(const Ref<Image> &p_image) {
+	Array results;
+	ERR_FAIL_COND_V(p_image.is_null() || p_image->empty(), results);
+	ERR_FAIL_COND_V_MSG(p_image->is_compressed(), results, "Tensorflow: pipeline input image can't be compressed");
+
+	if (runtimes.empty()) {
+		// Never built, or evicted to stay within the memory budget.
+		ERR_FAIL_COND_V(!_build_interpreters(), results);
+	}
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->touch(this);
+	}
+
+	_run_stages(0, p_image, Rect2(Point2(), p_image->get_size()), 1.0, results);
+	return results;
+}
+
+void TensorflowPipeline::release_interpreter() {
+	if (runtimes.empty()) {
+		return;
+	}
+	// Later stages may alias earlier outputs, tear them down first.
+	while (!runtimes.empty()) {
+		runtimes.pop_back();
+	}
+	for (int i = 0; i < stages.size(); i++) {
+		Ref<TensorflowModel> model = stages[i].model;
+		if (model.is_valid()) {
+			model->unregister_owner(this);
+		}
+	}
+	if (TensorflowMemory::get_singleton()) {
+		TensorflowMemory::get_singleton()->unregister_interpreter(this);
+	}
+}
+
+void TensorflowPipeline::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_stage_count", "count"), &TensorflowPipeline::set_stage_count);
+	ClassDB::bind_method(D_METHOD("get_stage_count"), &TensorflowPipeline::get_stage_count);
+	ClassDB::bind_method(D_METHOD("add_model_stage", "model"), &TensorflowPipeline::add_model_stage);
+	ClassDB::bind_method(D_METHOD("add_crop_resize_stage", "boxes_output", "scores_output", "score_threshold", "max_crops"), &TensorflowPipeline::add_crop_resize_stage, DEFVAL(0), DEFVAL(2), DEFVAL(0.5), DEFVAL(10));
+	ClassDB::bind_method(D_METHOD("clear_stages"), &TensorflowPipeline::clear_stages);
+	ClassDB::bind_method(D_METHOD("set_stage_type", "stage", "type"), &TensorflowPipeline::set_stage_type);
+	ClassDB::bind_method(D_METHOD("get_stage_type", "stage"), &TensorflowPipeline::get_stage_type);
+	ClassDB::bind_method(D_METHOD("set_stage_model", "stage", "model"), &TensorflowPipeline::set_stage_model);
+	ClassDB::bind_method(D_METHOD("get_stage_model", "stage"), &TensorflowPipeline::get_stage_model);
+	ClassDB::bind_method(D_METHOD("set_stage_boxes_output", "stage", "output"), &TensorflowPipeline::set_stage_boxes_output);
+	ClassDB::bind_method(D_METHOD("get_stage_boxes_output", "stage"), &TensorflowPipeline::get_stage_boxes_output);
+	ClassDB::bind_method(D_METHOD("set_stage_scores_output", "stage", "output"), &TensorflowPipeline::set_stage_scores_output);
+	ClassDB::bind_method(D_METHOD("get_stage_scores_output", "stage"), &TensorflowPipeline::get_stage_scores_output);
+	ClassDB::bind_method(D_METHOD("set_stage_score_threshold", "stage", "threshold"), &TensorflowPipeline::set_stage_score_threshold);
+	ClassDB::bind_method(D_METHOD("get_stage_score_threshold", "stage"), &TensorflowPipeline::get_stage_score_threshold);
+	ClassDB::bind_method(D_METHOD("set_stage_max_crops", "stage", "max_crops"), &TensorflowPipeline::set_stage_max_crops);
+	ClassDB::bind_method(D_METHOD("get_stage_max_crops", "stage"), &TensorflowPipeline::get_stage_max_crops);
+	ClassDB::bind_method(D_METHOD("run", "image"), &TensorflowPipeline::run);
+	ClassDB::bind_method(D_METHOD("release_interpreter"), &TensorflowPipeline::release_interpreter);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "stage_count", PROPERTY_HINT_RANGE, "0,64,1,or_greater"), "set_stage_count", "get_stage_count");
+
+	BIND_ENUM_CONSTANT(STAGE_MODEL);
+	BIND_ENUM_CONSTANT(STAGE_CROP_RESIZE);
+}
+
+TensorflowPipeline::TensorflowPipeline() {
+}
+
+TensorflowPipeline::~TensorflowPipeline() {
+	release_interpreter();
+}
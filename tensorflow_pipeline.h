@@ -0,0 +1,123 @@
+/*************************************************************************/
+/*  tensorflow_pipeline.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TENSORFLOW_PIPELINE_H
+#define TENSORFLOW_PIPELINE_H
+
+#include "core/image.h"
+#include "core/resource.h"
+#include "loader_tflite.h"
+#include <tensorflow/lite/interpreter.h>
+#include <tensorflow/lite/model.h>
+
+#include <memory>
+#include <vector>
+
+// Chains several models in native code. Consecutive model stages hand their
+// tensors over directly, and crop/resize stages fan the source image out into
+// one run of the following stages per detection.
+class TensorflowPipeline : public Resource {
+	GDCLASS(TensorflowPipeline, Resource);
+
+public:
+	enum StageType {
+		STAGE_MODEL,
+		STAGE_CROP_RESIZE,
+	};
+
+private:
+	struct Stage {
+		StageType type;
+		Ref<TensorflowModel> model;
+		int boxes_output;
+		int scores_output;
+		float score_threshold;
+		int max_crops;
+
+		Stage() {
+			type = STAGE_MODEL;
+			boxes_output = 0;
+			scores_output = 2;
+			score_threshold = 0.5;
+			max_crops = 10;
+		}
+	};
+
+	struct StageRuntime {
+		std::unique_ptr<tflite::FlatBufferModel> model;
+		std::unique_ptr<tflite::Interpreter> interpreter;
+		// Input aliases the previous stage output, nothing to copy before invoking.
+		bool shared_input;
+	};
+
+	Vector<Stage> stages;
+	std::vector<StageRuntime> runtimes;
+
+	bool _build_interpreters();
+	bool _fill_from_image(tflite::Interpreter *p_interpreter, const Ref<Image> &p_image, const Rect2 &p_rect);
+	bool _copy_tensor(const TfLiteTensor *p_from, TfLiteTensor *p_to);
+	void _run_stages(int p_from, const Ref<Image> &p_image, const Rect2 &p_rect, float p_score, Array &r_results);
+
+protected:
+	static void _bind_methods();
+	bool _set(const StringName &p_name, const Variant &p_value);
+	bool _get(const StringName &p_name, Variant &r_ret) const;
+	void _get_property_list(List<PropertyInfo> *p_list) const;
+
+public:
+	void set_stage_count(int p_count);
+	int get_stage_count() const;
+	int add_model_stage(const Ref<TensorflowModel> &p_model);
+	int add_crop_resize_stage(int p_boxes_output = 0, int p_scores_output = 2, float p_score_threshold = 0.5, int p_max_crops = 10);
+	void clear_stages();
+
+	void set_stage_type(int p_stage, StageType p_type);
+	StageType get_stage_type(int p_stage) const;
+	void set_stage_model(int p_stage, const Ref<TensorflowModel> &p_model);
+	Ref<TensorflowModel> get_stage_model(int p_stage) const;
+	void set_stage_boxes_output(int p_stage, int p_output);
+	int get_stage_boxes_output(int p_stage) const;
+	void set_stage_scores_output(int p_stage, int p_output);
+	int get_stage_scores_output(int p_stage) const;
+	void set_stage_score_threshold(int p_stage, float p_threshold);
+	float get_stage_score_threshold(int p_stage) const;
+	void set_stage_max_crops(int p_stage, int p_max_crops);
+	int get_stage_max_crops(int p_stage) const;
+
+	Array run(const Ref<Image> &p_image);
+	void release_interpreter();
+
+	TensorflowPipeline();
+	~TensorflowPipeline();
+};
+
+VARIANT_ENUM_CAST(TensorflowPipeline::StageType);
+
+#endif